@@ -0,0 +1,80 @@
+// occupancy_grid_bench.cc
+// Host benchmark for the occupancy grid update cost per frame.
+// Build: g++ -O2 -std=c++17 -Iinclude bench/occupancy_grid_bench.cc src/occupancy_grid.cc -o grid_bench
+#include "occupancy_grid.hh"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+
+namespace coralmicro {
+namespace {
+
+    constexpr int kZones = 64;
+    constexpr int kFrames = 20000;
+
+    struct Frame {
+        int16_t distance_mm[kZones];
+        uint8_t target_status[kZones];
+        uint8_t nb_target_detected[kZones];
+    };
+
+    // Small LCG so runs are repeatable
+    uint32_t next_random(uint32_t* state) {
+        *state = *state * 1664525u + 1013904223u;
+        return *state >> 8;
+    }
+
+    // Flat wall ahead with noise and ~10% invalid zones
+    void make_frame(Frame* frame, uint32_t* state) {
+        for (int zone = 0; zone < kZones; zone++) {
+            uint32_t r = next_random(state);
+            frame->distance_mm[zone] = static_cast<int16_t>(1500 + (zone % 8) * 150 + r % 40);
+            frame->target_status[zone] = (r % 10 == 0) ? 4 : 5;
+            frame->nb_target_detected[zone] = 1;
+        }
+    }
+
+    void run(const char* name, int sensors) {
+        auto grid = std::make_unique<OccupancyGrid>();
+        auto frames = std::make_unique<Frame[]>(64);
+        GridDelta deltas[256];
+
+        uint32_t state = 1;
+        for (int i = 0; i < 64; i++) {
+            make_frame(&frames[i], &state);
+        }
+        for (int s = 0; s < sensors; s++) {
+            SensorPose pose = {0, 0, 100, 90.0f * static_cast<float>(s), 0.0f};
+            grid->add_sensor(static_cast<uint8_t>(s), pose, 8);
+        }
+
+        size_t delta_total = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < kFrames; i++) {
+            const Frame& frame = frames[i % 64];
+            for (int s = 0; s < sensors; s++) {
+                grid->integrate(static_cast<uint8_t>(s), frame.distance_mm,
+                    frame.target_status, frame.nb_target_detected, 1);
+            }
+            delta_total += grid->collect_deltas(deltas, 256);
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+        printf("%-12s sensors=%d  %8.0f ns/frame  %8.0f ns/sensor-frame  %.2f deltas/frame\r\n",
+            name, sensors, ns / kFrames, ns / kFrames / sensors,
+            static_cast<double>(delta_total) / kFrames);
+    }
+
+} // namespace
+} // namespace coralmicro
+
+int main() {
+    printf("Occupancy grid %dx%dx%d, %d mm cells, %d frames\r\n",
+        coralmicro::kGridDimX, coralmicro::kGridDimY, coralmicro::kGridDimZ,
+        coralmicro::kCellSizeMm, coralmicro::kFrames);
+    coralmicro::run("single", 1);
+    coralmicro::run("quad", 4);
+    return 0;
+}
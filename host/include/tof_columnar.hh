@@ -0,0 +1,74 @@
+// tof_columnar.hh
+#pragma once
+
+// C++ standard library
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+#include "tof_stream.hh"
+
+namespace tof_host {
+
+    // Columnar capture export (.tofc), all values little-endian.
+    //
+    // File header, 16 bytes:
+    //   char magic[4] = "TOFC", uint16 version, uint16 zones,
+    //   uint32 row_group_frames, uint32 reserved
+    //
+    // Then row groups until end of file, each starting with uint32 n followed
+    // by one contiguous array of n values per column, in this order:
+    //   uint64 index, int64 host_time_ns, int64 sequence, int64 grid_sequence,
+    //   uint8 has_zones, int16 temperature_c, uint64 valid_mask,
+    //   int32 fastpath_us, int32 grid_update_us, int32 grid_deltas,
+    //   int16 distance_mm[zones][n], uint16 signal_per_spad[zones][n],
+    //   uint8 num_rois, uint16 roi_min_mm[kMaxRois][n],
+    //   uint8 roi_zone[kMaxRois][n], uint8 roi_valid_count[kMaxRois][n]
+    //
+    // Absent device values are -1 and zones without a target INT16_MIN.
+    // ROIs at or past num_rois are absent (min 0xFFFF, zone 0xFF, count 0);
+    // a present ROI with no obstacle also reads 65535:255:0, as on the device.
+    static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
+        "The .tofc writer stores columns in native byte order");
+
+    static constexpr uint16_t kColumnarVersion = 2;
+    static constexpr uint32_t kRowGroupFrames = 4096;
+
+    class ColumnarWriter {
+    public:
+        ColumnarWriter() = default;
+        ~ColumnarWriter();
+        ColumnarWriter(const ColumnarWriter&) = delete;
+        ColumnarWriter& operator=(const ColumnarWriter&) = delete;
+
+        // Column buffers are allocated here, append() does not allocate
+        bool open(const char* path);
+        bool append(const Frame& frame);
+        bool close();
+
+        bool is_open() const { return file_ != nullptr; }
+
+    private:
+        bool flush_group();
+
+        FILE* file_ = nullptr;
+        uint32_t count_ = 0;
+        std::vector<uint64_t> index_;
+        std::vector<int64_t> host_time_ns_;
+        std::vector<int64_t> sequence_;
+        std::vector<int64_t> grid_sequence_;
+        std::vector<uint8_t> has_zones_;
+        std::vector<int16_t> temperature_c_;
+        std::vector<uint64_t> valid_mask_;
+        std::vector<int32_t> fastpath_us_;
+        std::vector<int32_t> grid_update_us_;
+        std::vector<int32_t> grid_deltas_;
+        std::vector<int16_t> distance_mm_;       // [zone][frame]
+        std::vector<uint16_t> signal_per_spad_;  // [zone][frame]
+        std::vector<uint8_t> num_rois_;
+        std::vector<uint16_t> roi_min_mm_;       // [roi][frame]
+        std::vector<uint8_t> roi_zone_;          // [roi][frame]
+        std::vector<uint8_t> roi_valid_count_;   // [roi][frame]
+    };
+
+} // namespace tof_host
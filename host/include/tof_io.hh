@@ -0,0 +1,36 @@
+// tof_io.hh
+#pragma once
+
+// C++ standard library
+#include <stddef.h>
+#include <stdint.h>
+
+namespace tof_host {
+
+    // Read-only memory mapping of a recorded capture
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool open(const char* path);
+        void close();
+
+        const char* data() const { return data_; }
+        size_t size() const { return size_; }
+
+    private:
+        const char* data_ = nullptr;
+        size_t size_ = 0;
+    };
+
+    // Open a serial device in raw non-blocking mode, returns -1 on failure
+    int open_serial(const char* path, int baud);
+
+    bool is_serial_device(const char* path);
+
+    int64_t monotonic_ns();
+
+} // namespace tof_host
@@ -0,0 +1,137 @@
+// tof_stream.hh
+#pragma once
+
+// C++ standard library
+#include <stddef.h>
+#include <stdint.h>
+
+namespace tof_host {
+
+    static constexpr int kZonesPerSide = 8;
+    static constexpr int kZones = kZonesPerSide * kZonesPerSide;
+    static constexpr int kMaxRois = 8;
+    static constexpr size_t kMaxLineLength = 2048;
+    static constexpr int16_t kNoTarget = INT16_MIN;
+
+    // Longest integer accepted by the parser, anything longer is corrupt
+    static constexpr int kMaxIntDigits = 12;
+
+    // Sequence jumps larger than this (or backwards) are treated as a resync
+    // after corruption or a device restart, not as dropped frames
+    static constexpr int64_t kMaxSequenceGap = 1000;
+
+    // Nearest-obstacle result from a $NOB packet
+    struct RoiResult {
+        uint16_t min_mm;
+        uint8_t zone;
+        uint8_t valid_count;
+    };
+
+    // One frame: the $NOB/$OGD packets of a device frame plus its print_results
+    // block when the device prints full frames. With kPrintFullFrame off only
+    // the packets arrive and has_zones is 0. Device fields that were not
+    // received are -1.
+    struct Frame {
+        uint64_t index;            // Host frame counter
+        int64_t host_time_ns;      // Arrival time, 0 when replaying a capture
+        int64_t sequence;          // Device $NOB sequence
+        int64_t grid_sequence;     // Device $OGD sequence
+        uint8_t has_zones;         // print_results block received
+        int16_t temperature_c;
+        int16_t distance_mm[kZones];  // kNoTarget when no target was detected
+        uint16_t signal_per_spad[kZones];
+        uint64_t valid_mask;       // Zones listed as valid (status 5)
+        int32_t fastpath_us;       // Device fast path compute time
+        int32_t grid_update_us;    // Device occupancy grid update time
+        int32_t grid_deltas;
+        uint8_t num_rois;
+        RoiResult rois[kMaxRois];
+    };
+
+    // Device read-to-publish latency from a $NOL line
+    struct LatencyReport {
+        uint32_t frames;
+        uint32_t min_us;
+        uint32_t max_us;
+        uint32_t avg_us;
+    };
+
+    struct StreamStats {
+        uint64_t bytes;
+        uint64_t lines;
+        uint64_t frames;
+        uint64_t dropped_frames;   // Gaps in the $NOB sequence
+        uint64_t resyncs;          // Backward or implausible $NOB sequence jumps
+        uint64_t parse_errors;     // Malformed lines and incomplete frames
+        uint64_t overlong_lines;
+    };
+
+    class FrameSink {
+    public:
+        virtual ~FrameSink() = default;
+        virtual void on_frame(const Frame& frame) = 0;
+        virtual void on_latency(const LatencyReport& report) { (void)report; }
+    };
+
+    // Streaming parser for the device serial output. Complete lines are parsed
+    // in place, only a line split across two feed() calls is copied, and no
+    // memory is allocated after construction.
+    class StreamParser {
+    public:
+        explicit StreamParser(FrameSink* sink);
+
+        // host_time_ns is stamped on frames completed by this chunk
+        void feed(const char* data, size_t size, int64_t host_time_ns);
+
+        // Parse a trailing line without newline and emit a pending frame
+        void finish();
+
+        // Forget partial state, keeps stats
+        void reset();
+
+        const StreamStats& stats() const { return stats_; }
+
+    private:
+        enum class State {
+            kIdle,
+            kGrid,
+            kValid,
+        };
+
+        struct Pending {
+            int64_t sequence;
+            int64_t grid_sequence;
+            int32_t fastpath_us;
+            int32_t grid_update_us;
+            int32_t grid_deltas;
+            uint8_t num_rois;
+            RoiResult rois[kMaxRois];
+        };
+
+        void parse_line(const char* line, const char* end);
+        bool parse_header(const char* p, const char* end);
+        bool parse_row(const char* p, const char* end);
+        bool parse_valid(const char* p, const char* end);
+        bool parse_nob(const char* p, const char* end);
+        bool parse_ogd(const char* p, const char* end);
+        bool parse_nol(const char* p, const char* end);
+        void begin_frame();
+        void load_pending();
+        void emit_packet_frame();
+        void emit_frame();
+        void clear_pending();
+
+        FrameSink* sink_;
+        StreamStats stats_;
+        State state_;
+        uint8_t rows_seen_;
+        int64_t now_ns_;
+        int64_t last_sequence_;
+        Frame frame_;
+        Pending pending_;
+        size_t carry_len_;
+        bool discarding_;
+        char carry_[kMaxLineLength];
+    };
+
+} // namespace tof_host
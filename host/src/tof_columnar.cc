@@ -0,0 +1,148 @@
+// tof_columnar.cc
+#include "tof_columnar.hh"
+
+#include <string.h>
+
+namespace tof_host {
+
+    namespace {
+        template <typename T>
+        bool write_column(FILE* file, const T* values, uint32_t count) {
+            return fwrite(values, sizeof(T), count, file) == count;
+        }
+    }
+
+    ColumnarWriter::~ColumnarWriter() {
+        close();
+    }
+
+    bool ColumnarWriter::open(const char* path) {
+        close();
+
+        file_ = fopen(path, "wb");
+        if (!file_) {
+            fprintf(stderr, "Failed to open %s for export\n", path);
+            return false;
+        }
+
+        index_.resize(kRowGroupFrames);
+        host_time_ns_.resize(kRowGroupFrames);
+        sequence_.resize(kRowGroupFrames);
+        grid_sequence_.resize(kRowGroupFrames);
+        has_zones_.resize(kRowGroupFrames);
+        temperature_c_.resize(kRowGroupFrames);
+        valid_mask_.resize(kRowGroupFrames);
+        fastpath_us_.resize(kRowGroupFrames);
+        grid_update_us_.resize(kRowGroupFrames);
+        grid_deltas_.resize(kRowGroupFrames);
+        distance_mm_.resize(kZones * kRowGroupFrames);
+        signal_per_spad_.resize(kZones * kRowGroupFrames);
+        num_rois_.resize(kRowGroupFrames);
+        roi_min_mm_.resize(kMaxRois * kRowGroupFrames);
+        roi_zone_.resize(kMaxRois * kRowGroupFrames);
+        roi_valid_count_.resize(kMaxRois * kRowGroupFrames);
+        count_ = 0;
+
+        uint8_t header[16] = {'T', 'O', 'F', 'C'};
+        uint16_t version = kColumnarVersion;
+        uint16_t zones = kZones;
+        uint32_t group_frames = kRowGroupFrames;
+        memcpy(header + 4, &version, sizeof(version));
+        memcpy(header + 6, &zones, sizeof(zones));
+        memcpy(header + 8, &group_frames, sizeof(group_frames));
+        if (fwrite(header, sizeof(header), 1, file_) != 1) {
+            fprintf(stderr, "Failed to write export header\n");
+            fclose(file_);
+            file_ = nullptr;
+            return false;
+        }
+
+        return true;
+    }
+
+    bool ColumnarWriter::append(const Frame& frame) {
+        if (!file_) {
+            return false;
+        }
+
+        uint32_t i = count_;
+        index_[i] = frame.index;
+        host_time_ns_[i] = frame.host_time_ns;
+        sequence_[i] = frame.sequence;
+        grid_sequence_[i] = frame.grid_sequence;
+        has_zones_[i] = frame.has_zones;
+        temperature_c_[i] = frame.temperature_c;
+        valid_mask_[i] = frame.valid_mask;
+        fastpath_us_[i] = frame.fastpath_us;
+        grid_update_us_[i] = frame.grid_update_us;
+        grid_deltas_[i] = frame.grid_deltas;
+        for (int zone = 0; zone < kZones; zone++) {
+            distance_mm_[zone * kRowGroupFrames + i] = frame.distance_mm[zone];
+            signal_per_spad_[zone * kRowGroupFrames + i] = frame.signal_per_spad[zone];
+        }
+        num_rois_[i] = frame.num_rois;
+        for (int roi = 0; roi < kMaxRois; roi++) {
+            bool present = roi < frame.num_rois;
+            roi_min_mm_[roi * kRowGroupFrames + i] = present ? frame.rois[roi].min_mm : 0xFFFF;
+            roi_zone_[roi * kRowGroupFrames + i] = present ? frame.rois[roi].zone : 0xFF;
+            roi_valid_count_[roi * kRowGroupFrames + i] = present ? frame.rois[roi].valid_count : 0;
+        }
+
+        if (++count_ == kRowGroupFrames) {
+            return flush_group();
+        }
+        return true;
+    }
+
+    bool ColumnarWriter::flush_group() {
+        uint32_t n = count_;
+        count_ = 0;
+        if (n == 0) {
+            return true;
+        }
+
+        bool ok = write_column(file_, &n, 1) &&
+            write_column(file_, index_.data(), n) &&
+            write_column(file_, host_time_ns_.data(), n) &&
+            write_column(file_, sequence_.data(), n) &&
+            write_column(file_, grid_sequence_.data(), n) &&
+            write_column(file_, has_zones_.data(), n) &&
+            write_column(file_, temperature_c_.data(), n) &&
+            write_column(file_, valid_mask_.data(), n) &&
+            write_column(file_, fastpath_us_.data(), n) &&
+            write_column(file_, grid_update_us_.data(), n) &&
+            write_column(file_, grid_deltas_.data(), n);
+        for (int zone = 0; ok && zone < kZones; zone++) {
+            ok = write_column(file_, &distance_mm_[zone * kRowGroupFrames], n);
+        }
+        for (int zone = 0; ok && zone < kZones; zone++) {
+            ok = write_column(file_, &signal_per_spad_[zone * kRowGroupFrames], n);
+        }
+        ok = ok && write_column(file_, num_rois_.data(), n);
+        for (int roi = 0; ok && roi < kMaxRois; roi++) {
+            ok = write_column(file_, &roi_min_mm_[roi * kRowGroupFrames], n);
+        }
+        for (int roi = 0; ok && roi < kMaxRois; roi++) {
+            ok = write_column(file_, &roi_zone_[roi * kRowGroupFrames], n);
+        }
+        for (int roi = 0; ok && roi < kMaxRois; roi++) {
+            ok = write_column(file_, &roi_valid_count_[roi * kRowGroupFrames], n);
+        }
+
+        if (!ok) {
+            fprintf(stderr, "Failed to write export row group\n");
+        }
+        return ok;
+    }
+
+    bool ColumnarWriter::close() {
+        if (!file_) {
+            return true;
+        }
+        bool ok = flush_group();
+        ok = (fclose(file_) == 0) && ok;
+        file_ = nullptr;
+        return ok;
+    }
+
+} // namespace tof_host
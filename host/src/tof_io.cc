@@ -0,0 +1,123 @@
+// tof_io.cc
+#include "tof_io.hh"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace tof_host {
+
+    namespace {
+        speed_t to_speed(int baud) {
+            switch (baud) {
+                case 9600: return B9600;
+                case 19200: return B19200;
+                case 38400: return B38400;
+                case 57600: return B57600;
+                case 115200: return B115200;
+                case 230400: return B230400;
+                case 460800: return B460800;
+                case 921600: return B921600;
+                default: return B0;
+            }
+        }
+    }
+
+    MappedFile::~MappedFile() {
+        close();
+    }
+
+    bool MappedFile::open(const char* path) {
+        close();
+
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) {
+            fprintf(stderr, "Failed to open %s: %s\n", path, strerror(errno));
+            return false;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            fprintf(stderr, "Failed to stat %s: %s\n", path, strerror(errno));
+            ::close(fd);
+            return false;
+        }
+
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ == 0) {
+            ::close(fd);
+            return true;
+        }
+
+        void* map = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED) {
+            fprintf(stderr, "Failed to map %s: %s\n", path, strerror(errno));
+            size_ = 0;
+            return false;
+        }
+
+        // Captures are parsed front to back once per pass
+        madvise(map, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(map);
+        return true;
+    }
+
+    void MappedFile::close() {
+        if (data_) {
+            munmap(const_cast<char*>(data_), size_);
+        }
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    int open_serial(const char* path, int baud) {
+        speed_t speed = to_speed(baud);
+        if (speed == B0) {
+            fprintf(stderr, "Unsupported baud rate %d\n", baud);
+            return -1;
+        }
+
+        int fd = ::open(path, O_RDONLY | O_NOCTTY | O_NONBLOCK);
+        if (fd < 0) {
+            fprintf(stderr, "Failed to open %s: %s\n", path, strerror(errno));
+            return -1;
+        }
+
+        struct termios tio;
+        if (tcgetattr(fd, &tio) != 0) {
+            fprintf(stderr, "Failed to read attributes of %s: %s\n", path, strerror(errno));
+            ::close(fd);
+            return -1;
+        }
+        cfmakeraw(&tio);
+        cfsetispeed(&tio, speed);
+        cfsetospeed(&tio, speed);
+        tio.c_cflag |= CLOCAL | CREAD;
+        if (tcsetattr(fd, TCSANOW, &tio) != 0) {
+            fprintf(stderr, "Failed to configure %s: %s\n", path, strerror(errno));
+            ::close(fd);
+            return -1;
+        }
+
+        return fd;
+    }
+
+    bool is_serial_device(const char* path) {
+        struct stat st;
+        return stat(path, &st) == 0 && S_ISCHR(st.st_mode);
+    }
+
+    int64_t monotonic_ns() {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+    }
+
+} // namespace tof_host
@@ -0,0 +1,389 @@
+// tof_stream.cc
+#include "tof_stream.hh"
+
+#include <string.h>
+
+namespace tof_host {
+
+    namespace {
+        bool starts_with(const char* p, const char* end, const char* prefix, size_t len) {
+            return static_cast<size_t>(end - p) >= len && memcmp(p, prefix, len) == 0;
+        }
+
+        void skip_spaces(const char*& p, const char* end) {
+            while (p < end && *p == ' ') {
+                p++;
+            }
+        }
+
+        // Parse a decimal integer after optional spaces, advancing p
+        bool parse_int(const char*& p, const char* end, int64_t* value) {
+            skip_spaces(p, end);
+            bool negative = false;
+            if (p < end && *p == '-') {
+                negative = true;
+                p++;
+            }
+            if (p >= end || *p < '0' || *p > '9') {
+                return false;
+            }
+            int64_t result = 0;
+            int digits = 0;
+            while (p < end && *p >= '0' && *p <= '9') {
+                if (++digits > kMaxIntDigits) {
+                    return false;
+                }
+                result = result * 10 + (*p - '0');
+                p++;
+            }
+            *value = negative ? -result : result;
+            return true;
+        }
+
+        bool expect(const char*& p, const char* end, char c) {
+            if (p >= end || *p != c) {
+                return false;
+            }
+            p++;
+            return true;
+        }
+    }
+
+    StreamParser::StreamParser(FrameSink* sink)
+        : sink_(sink), stats_() {
+        reset();
+    }
+
+    void StreamParser::reset() {
+        state_ = State::kIdle;
+        rows_seen_ = 0;
+        now_ns_ = 0;
+        last_sequence_ = -1;
+        carry_len_ = 0;
+        discarding_ = false;
+        memset(&frame_, 0, sizeof(frame_));
+        clear_pending();
+    }
+
+    void StreamParser::clear_pending() {
+        pending_.sequence = -1;
+        pending_.grid_sequence = -1;
+        pending_.fastpath_us = -1;
+        pending_.grid_update_us = -1;
+        pending_.grid_deltas = -1;
+        pending_.num_rois = 0;
+    }
+
+    void StreamParser::feed(const char* data, size_t size, int64_t host_time_ns) {
+        const char* p = data;
+        const char* end = data + size;
+        now_ns_ = host_time_ns;
+        stats_.bytes += size;
+
+        while (p < end) {
+            const char* newline = static_cast<const char*>(memchr(p, '\n', end - p));
+            const char* line_end = newline ? newline : end;
+            size_t len = line_end - p;
+
+            if (carry_len_ == 0 && !discarding_ && newline) {
+                // Whole line inside this chunk, parse in place
+                parse_line(p, line_end);
+            } else {
+                if (!discarding_ && carry_len_ + len > kMaxLineLength) {
+                    stats_.overlong_lines++;
+                    discarding_ = true;
+                    carry_len_ = 0;
+                }
+                if (!discarding_) {
+                    memcpy(carry_ + carry_len_, p, len);
+                    carry_len_ += len;
+                }
+                if (newline) {
+                    if (!discarding_) {
+                        parse_line(carry_, carry_ + carry_len_);
+                    }
+                    carry_len_ = 0;
+                    discarding_ = false;
+                }
+            }
+
+            if (!newline) {
+                break;
+            }
+            p = newline + 1;
+        }
+    }
+
+    void StreamParser::finish() {
+        if (carry_len_ > 0 && !discarding_) {
+            parse_line(carry_, carry_ + carry_len_);
+        }
+        carry_len_ = 0;
+        discarding_ = false;
+
+        if (state_ == State::kValid) {
+            emit_frame();
+        }
+        state_ = State::kIdle;
+
+        if (pending_.sequence >= 0) {
+            emit_packet_frame();
+        }
+    }
+
+    void StreamParser::parse_line(const char* line, const char* end) {
+        stats_.lines++;
+
+        // Lines end in \r\n and frames start with \r\n
+        while (line < end && *line == '\r') {
+            line++;
+        }
+        while (end > line && end[-1] == '\r') {
+            end--;
+        }
+
+        if (line == end) {
+            if (state_ == State::kValid) {
+                emit_frame();
+                state_ = State::kIdle;
+            }
+            return;
+        }
+
+        bool ok = true;
+        if (*line == '$') {
+            if (starts_with(line, end, "$NOB,", 5)) {
+                ok = parse_nob(line + 5, end);
+            } else if (starts_with(line, end, "$OGD,", 5)) {
+                ok = parse_ogd(line + 5, end);
+            } else if (starts_with(line, end, "$NOL,", 5)) {
+                ok = parse_nol(line + 5, end);
+            }
+        } else if (starts_with(line, end, "=== VL53L8CX", 12)) {
+            if (state_ == State::kValid) {
+                emit_frame();
+            } else if (state_ == State::kGrid) {
+                stats_.parse_errors++;
+            }
+            begin_frame();
+            ok = parse_header(line, end);
+            if (!ok) {
+                state_ = State::kIdle;
+            }
+        } else if (state_ == State::kGrid && *line == 'R') {
+            ok = parse_row(line + 1, end);
+        } else if (state_ == State::kGrid && starts_with(line, end, "Valid measurements", 18)) {
+            if (rows_seen_ != 0xFF) {
+                ok = false;
+                state_ = State::kIdle;
+            } else {
+                state_ = State::kValid;
+            }
+        } else if (state_ == State::kValid && starts_with(line, end, "Zone", 4)) {
+            ok = parse_valid(line + 4, end);
+        }
+        // Column headers, separators and log messages are ignored
+
+        if (!ok) {
+            stats_.parse_errors++;
+        }
+    }
+
+    void StreamParser::begin_frame() {
+        state_ = State::kGrid;
+        rows_seen_ = 0;
+        frame_.host_time_ns = 0;
+        frame_.temperature_c = 0;
+        frame_.valid_mask = 0;
+        frame_.has_zones = 1;
+        memset(frame_.signal_per_spad, 0, sizeof(frame_.signal_per_spad));
+        load_pending();
+    }
+
+    void StreamParser::emit_packet_frame() {
+        // Packets of a device frame that had no print_results block
+        frame_.temperature_c = 0;
+        frame_.valid_mask = 0;
+        frame_.has_zones = 0;
+        for (int zone = 0; zone < kZones; zone++) {
+            frame_.distance_mm[zone] = kNoTarget;
+        }
+        memset(frame_.signal_per_spad, 0, sizeof(frame_.signal_per_spad));
+        load_pending();
+        emit_frame();
+    }
+
+    void StreamParser::load_pending() {
+        // $NOB and $OGD are published ahead of the frame they belong to
+        frame_.sequence = pending_.sequence;
+        frame_.grid_sequence = pending_.grid_sequence;
+        frame_.fastpath_us = pending_.fastpath_us;
+        frame_.grid_update_us = pending_.grid_update_us;
+        frame_.grid_deltas = pending_.grid_deltas;
+        frame_.num_rois = pending_.num_rois;
+        memcpy(frame_.rois, pending_.rois, sizeof(RoiResult) * pending_.num_rois);
+        clear_pending();
+    }
+
+    void StreamParser::emit_frame() {
+        if (frame_.sequence >= 0) {
+            if (last_sequence_ >= 0) {
+                int64_t gap = frame_.sequence - last_sequence_;
+                if (gap <= 0 || gap > kMaxSequenceGap) {
+                    stats_.resyncs++;
+                } else {
+                    stats_.dropped_frames += gap - 1;
+                }
+            }
+            last_sequence_ = frame_.sequence;
+        }
+
+        frame_.index = stats_.frames++;
+        frame_.host_time_ns = now_ns_;
+        if (sink_) {
+            sink_->on_frame(frame_);
+        }
+    }
+
+    bool StreamParser::parse_header(const char* p, const char* end) {
+        // === VL53L8CX Sensor Reading (Temp: 35°C) ===
+        const char* temp = static_cast<const char*>(memchr(p, ':', end - p));
+        if (!temp) {
+            return false;
+        }
+        p = temp + 1;
+        int64_t value;
+        if (!parse_int(p, end, &value)) {
+            return false;
+        }
+        frame_.temperature_c = static_cast<int16_t>(value);
+        return true;
+    }
+
+    bool StreamParser::parse_row(const char* p, const char* end) {
+        // R3 |  1234  ---- ... |
+        if (p >= end || *p < '0' || *p >= '0' + kZonesPerSide) {
+            return false;
+        }
+        int row = *p++ - '0';
+        skip_spaces(p, end);
+        if (!expect(p, end, '|')) {
+            return false;
+        }
+
+        int16_t* distances = frame_.distance_mm + row * kZonesPerSide;
+        for (int col = 0; col < kZonesPerSide; col++) {
+            skip_spaces(p, end);
+            if (starts_with(p, end, "--", 2)) {
+                if (!starts_with(p, end, "----", 4)) {
+                    return false;
+                }
+                p += 4;
+                distances[col] = kNoTarget;
+                continue;
+            }
+            // The ULD can report distances <= 0, printed as signed values
+            int64_t value;
+            if (!parse_int(p, end, &value)) {
+                return false;
+            }
+            distances[col] = static_cast<int16_t>(value);
+        }
+
+        rows_seen_ |= 1u << row;
+        return true;
+    }
+
+    bool StreamParser::parse_valid(const char* p, const char* end) {
+        // Zone 12: 1234mm (Signal:  123)
+        int64_t zone, distance, signal;
+        if (!parse_int(p, end, &zone) || zone < 0 || zone >= kZones || !expect(p, end, ':')) {
+            return false;
+        }
+        if (!parse_int(p, end, &distance)) {
+            return false;
+        }
+        const char* colon = static_cast<const char*>(memchr(p, ':', end - p));
+        if (!colon) {
+            return false;
+        }
+        p = colon + 1;
+        if (!parse_int(p, end, &signal)) {
+            return false;
+        }
+
+        frame_.valid_mask |= 1ull << zone;
+        frame_.signal_per_spad[zone] = static_cast<uint16_t>(signal);
+        return true;
+    }
+
+    bool StreamParser::parse_nob(const char* p, const char* end) {
+        // $NOB,<seq>,<compute us>,<min mm>:<zone>:<valid count>,...
+        // An earlier $NOB still pending had no print_results block after it
+        if (pending_.sequence >= 0) {
+            emit_packet_frame();
+        }
+
+        int64_t sequence, compute_us;
+        if (!parse_int(p, end, &sequence) || !expect(p, end, ',') ||
+            !parse_int(p, end, &compute_us)) {
+            return false;
+        }
+
+        uint8_t num_rois = 0;
+        while (p < end && *p == ',' && num_rois < kMaxRois) {
+            p++;
+            int64_t min_mm, zone, count;
+            if (!parse_int(p, end, &min_mm) || !expect(p, end, ':') ||
+                !parse_int(p, end, &zone) || !expect(p, end, ':') ||
+                !parse_int(p, end, &count)) {
+                return false;
+            }
+            pending_.rois[num_rois++] = {
+                static_cast<uint16_t>(min_mm),
+                static_cast<uint8_t>(zone),
+                static_cast<uint8_t>(count),
+            };
+        }
+
+        pending_.sequence = sequence;
+        pending_.fastpath_us = static_cast<int32_t>(compute_us);
+        pending_.num_rois = num_rois;
+        return true;
+    }
+
+    bool StreamParser::parse_ogd(const char* p, const char* end) {
+        // $OGD,<seq>,<update us>,<count>,<pending>,<deltas>
+        int64_t sequence, update_us, count;
+        if (!parse_int(p, end, &sequence) || !expect(p, end, ',') ||
+            !parse_int(p, end, &update_us) || !expect(p, end, ',') ||
+            !parse_int(p, end, &count)) {
+            return false;
+        }
+        pending_.grid_sequence = sequence;
+        pending_.grid_update_us = static_cast<int32_t>(update_us);
+        pending_.grid_deltas = static_cast<int32_t>(count);
+        return true;
+    }
+
+    bool StreamParser::parse_nol(const char* p, const char* end) {
+        // $NOL,<frames>,<min us>,<max us>,<avg us>
+        int64_t values[4];
+        for (int i = 0; i < 4; i++) {
+            if ((i > 0 && !expect(p, end, ',')) || !parse_int(p, end, &values[i])) {
+                return false;
+            }
+        }
+        if (sink_) {
+            LatencyReport report = {
+                static_cast<uint32_t>(values[0]),
+                static_cast<uint32_t>(values[1]),
+                static_cast<uint32_t>(values[2]),
+                static_cast<uint32_t>(values[3]),
+            };
+            sink_->on_latency(report);
+        }
+        return true;
+    }
+
+} // namespace tof_host
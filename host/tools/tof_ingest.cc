@@ -0,0 +1,430 @@
+// tof_ingest.cc
+// Ingest the device serial stream or recorded captures, report frame rate,
+// latency and drops, and optionally export to the columnar .tofc format.
+#include "tof_columnar.hh"
+#include "tof_io.hh"
+#include "tof_stream.hh"
+
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace tof_host {
+namespace {
+
+    constexpr size_t kReadChunk = 64 * 1024;
+
+    volatile sig_atomic_t g_stop = 0;
+
+    struct Options {
+        int baud = 115200;
+        int interval_ms = 1000;
+        int repeat = 1;
+        bool zones = false;
+        const char* export_path = nullptr;
+        const char* record_path = nullptr;
+        std::vector<const char*> inputs;
+    };
+
+    // Per input state, receives frames from its parser
+    class Stream : public FrameSink {
+    public:
+        explicit Stream(const char* path) : name(path), parser(this) {}
+
+        void on_frame(const Frame& frame) override {
+            if (writer.is_open() && !writer.append(frame)) {
+                // Stop exporting, main() reports the failure on close
+                fprintf(stderr, "%s: export failed, export stopped\n", name.c_str());
+                writer.close();
+                export_failed = true;
+            }
+            if (frame.host_time_ns && last.host_time_ns) {
+                int64_t gap = frame.host_time_ns - last.host_time_ns;
+                window_gap_total_ns += gap;
+                window_gaps++;
+                if (gap > window_gap_max_ns) {
+                    window_gap_max_ns = gap;
+                }
+            }
+            if (frame.fastpath_us >= 0) {
+                window_fastpath_us += frame.fastpath_us;
+                window_fastpath_frames++;
+            }
+            if (frame.grid_update_us >= 0) {
+                window_grid_us += frame.grid_update_us;
+                window_grid_frames++;
+            }
+            window_frames++;
+            last = frame;
+        }
+
+        void on_latency(const LatencyReport& report) override {
+            latency = report;
+            has_latency = true;
+        }
+
+        void reset_window() {
+            window_frames = 0;
+            window_gap_total_ns = 0;
+            window_gaps = 0;
+            window_gap_max_ns = 0;
+            window_fastpath_us = 0;
+            window_fastpath_frames = 0;
+            window_grid_us = 0;
+            window_grid_frames = 0;
+        }
+
+        std::string name;
+        StreamParser parser;
+        ColumnarWriter writer;
+        Frame last = {};
+        LatencyReport latency = {};
+        bool has_latency = false;
+        bool export_failed = false;
+        int fd = -1;
+        FILE* record = nullptr;
+
+        uint64_t window_frames = 0;
+        int64_t window_gap_total_ns = 0;
+        uint64_t window_gaps = 0;
+        int64_t window_gap_max_ns = 0;
+        int64_t window_fastpath_us = 0;
+        uint64_t window_fastpath_frames = 0;
+        int64_t window_grid_us = 0;
+        uint64_t window_grid_frames = 0;
+    };
+
+    void print_usage(const char* program) {
+        fprintf(stderr,
+            "Usage: %s [options] <serial device | capture file>...\n"
+            "  --baud N         Serial baud rate (default 115200)\n"
+            "  --interval-ms N  Live report interval (default 1000)\n"
+            "  --repeat N       Replay captures N times (default 1)\n"
+            "  --zones          Print the 8x8 view of the latest frame\n"
+            "  --export PATH    Export frames to columnar .tofc (.N suffix per extra input)\n"
+            "  --record PATH    Save raw serial bytes (.N suffix per extra input)\n",
+            program);
+    }
+
+    bool parse_options(int argc, char** argv, Options* options) {
+        for (int i = 1; i < argc; i++) {
+            const char* arg = argv[i];
+            bool has_value = i + 1 < argc;
+            if (strcmp(arg, "--baud") == 0 && has_value) {
+                options->baud = atoi(argv[++i]);
+            } else if (strcmp(arg, "--interval-ms") == 0 && has_value) {
+                options->interval_ms = atoi(argv[++i]);
+            } else if (strcmp(arg, "--repeat") == 0 && has_value) {
+                options->repeat = atoi(argv[++i]);
+            } else if (strcmp(arg, "--zones") == 0) {
+                options->zones = true;
+            } else if (strcmp(arg, "--export") == 0 && has_value) {
+                options->export_path = argv[++i];
+            } else if (strcmp(arg, "--record") == 0 && has_value) {
+                options->record_path = argv[++i];
+            } else if (arg[0] == '-') {
+                return false;
+            } else {
+                options->inputs.push_back(arg);
+            }
+        }
+        return !options->inputs.empty() && options->interval_ms > 0 && options->repeat > 0;
+    }
+
+    std::string output_path(const char* base, size_t index) {
+        std::string path = base;
+        if (index > 0) {
+            path += "." + std::to_string(index);
+        }
+        return path;
+    }
+
+    void print_zones(const Frame& frame) {
+        if (frame.has_zones) {
+            printf("  frame %llu seq %lld temp %dC\n",
+                static_cast<unsigned long long>(frame.index),
+                static_cast<long long>(frame.sequence),
+                frame.temperature_c);
+        } else {
+            printf("  frame %llu seq %lld (packets only)\n",
+                static_cast<unsigned long long>(frame.index),
+                static_cast<long long>(frame.sequence));
+        }
+        for (int row = 0; frame.has_zones && row < kZonesPerSide; row++) {
+            printf("  R%d |", row);
+            for (int col = 0; col < kZonesPerSide; col++) {
+                int zone = row * kZonesPerSide + col;
+                if (frame.distance_mm[zone] == kNoTarget) {
+                    printf("  ----");
+                } else {
+                    printf(" %4d%c", frame.distance_mm[zone],
+                        (frame.valid_mask >> zone) & 1 ? ' ' : '?');
+                }
+            }
+            printf(" |\n");
+        }
+        for (int i = 0; i < frame.num_rois; i++) {
+            printf("  ROI %d: min %u mm zone %u valid %u\n", i,
+                frame.rois[i].min_mm, frame.rois[i].zone, frame.rois[i].valid_count);
+        }
+    }
+
+    void print_device_timing(const Stream& stream) {
+        if (stream.window_fastpath_frames) {
+            printf("  fast path %.1f us", static_cast<double>(stream.window_fastpath_us) /
+                static_cast<double>(stream.window_fastpath_frames));
+        }
+        if (stream.window_grid_frames) {
+            printf("  grid update %.1f us", static_cast<double>(stream.window_grid_us) /
+                static_cast<double>(stream.window_grid_frames));
+        }
+        if (stream.has_latency) {
+            printf("  read-to-publish min/avg/max %u/%u/%u us",
+                stream.latency.min_us, stream.latency.avg_us, stream.latency.max_us);
+        }
+        printf("\n");
+    }
+
+    bool open_outputs(const Options& options, Stream* stream, size_t index) {
+        if (options.export_path) {
+            std::string path = output_path(options.export_path, index);
+            if (!stream->writer.open(path.c_str())) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    int replay(const Options& options, std::vector<std::unique_ptr<Stream>>& streams) {
+        uint64_t total_frames = 0;
+        uint64_t total_bytes = 0;
+        int64_t start = monotonic_ns();
+
+        for (size_t i = 0; i < streams.size(); i++) {
+            Stream& stream = *streams[i];
+            MappedFile file;
+            if (!file.open(stream.name.c_str())) {
+                return 1;
+            }
+
+            int64_t stream_start = monotonic_ns();
+            for (int pass = 0; pass < options.repeat && !g_stop; pass++) {
+                stream.parser.feed(file.data(), file.size(), 0);
+                stream.parser.finish();
+                stream.parser.reset();
+            }
+            double seconds = static_cast<double>(monotonic_ns() - stream_start) / 1e9;
+
+            const StreamStats& stats = stream.parser.stats();
+            printf("%s: %llu frames in %.3f s, %.0f frames/s, %.1f MB/s, "
+                "%llu dropped, %llu resyncs, %llu parse errors, %llu overlong lines\n",
+                stream.name.c_str(),
+                static_cast<unsigned long long>(stats.frames),
+                seconds,
+                static_cast<double>(stats.frames) / seconds,
+                static_cast<double>(stats.bytes) / seconds / 1e6,
+                static_cast<unsigned long long>(stats.dropped_frames),
+                static_cast<unsigned long long>(stats.resyncs),
+                static_cast<unsigned long long>(stats.parse_errors),
+                static_cast<unsigned long long>(stats.overlong_lines));
+            print_device_timing(stream);
+            if (options.zones && stats.frames) {
+                print_zones(stream.last);
+            }
+
+            total_frames += stats.frames;
+            total_bytes += stats.bytes;
+        }
+
+        if (streams.size() > 1) {
+            double seconds = static_cast<double>(monotonic_ns() - start) / 1e9;
+            printf("total: %llu frames, %.0f frames/s, %.1f MB/s\n",
+                static_cast<unsigned long long>(total_frames),
+                static_cast<double>(total_frames) / seconds,
+                static_cast<double>(total_bytes) / seconds / 1e6);
+        }
+        return 0;
+    }
+
+    bool close_stream(Stream* stream) {
+        bool ok = true;
+        stream->parser.finish();
+        close(stream->fd);
+        stream->fd = -1;
+        if (stream->record) {
+            ok = fclose(stream->record) == 0;
+            stream->record = nullptr;
+            if (!ok) {
+                fprintf(stderr, "%s: failed to close recording\n", stream->name.c_str());
+            }
+        }
+        return ok;
+    }
+
+    int live(const Options& options, std::vector<std::unique_ptr<Stream>>& streams) {
+        std::vector<pollfd> fds;
+        for (size_t i = 0; i < streams.size(); i++) {
+            Stream& stream = *streams[i];
+            stream.fd = open_serial(stream.name.c_str(), options.baud);
+            if (stream.fd < 0) {
+                return 1;
+            }
+            if (options.record_path) {
+                std::string path = output_path(options.record_path, i);
+                stream.record = fopen(path.c_str(), "wb");
+                if (!stream.record) {
+                    fprintf(stderr, "Failed to open %s for recording\n", path.c_str());
+                    return 1;
+                }
+            }
+            fds.push_back({stream.fd, POLLIN, 0});
+        }
+
+        static char buffer[kReadChunk];
+        int64_t window_start = monotonic_ns();
+        int64_t interval_ns = static_cast<int64_t>(options.interval_ms) * 1000000;
+        size_t open_streams = streams.size();
+        int ret = 0;
+
+        while (!g_stop && open_streams > 0) {
+            int ready = poll(fds.data(), fds.size(), options.interval_ms);
+            if (ready < 0 && errno != EINTR) {
+                perror("poll");
+                return 1;
+            }
+
+            for (size_t i = 0; ready > 0 && i < fds.size(); i++) {
+                if (fds[i].fd < 0 || !fds[i].revents) {
+                    continue;
+                }
+                Stream& stream = *streams[i];
+
+                // Drain what is buffered, then treat hangup, errors and EOF as end of stream
+                bool ended = (fds[i].revents & (POLLERR | POLLNVAL)) != 0;
+                ssize_t n = -1;
+                while (!ended && (n = read(stream.fd, buffer, sizeof(buffer))) != 0) {
+                    if (n < 0) {
+                        if (errno == EINTR) {
+                            continue;
+                        }
+                        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                            fprintf(stderr, "%s: read failed: %s\n", stream.name.c_str(), strerror(errno));
+                            ended = true;
+                        }
+                        break;
+                    }
+                    if (stream.record && fwrite(buffer, 1, n, stream.record) != static_cast<size_t>(n)) {
+                        fprintf(stderr, "%s: failed to write recording, recording stopped\n", stream.name.c_str());
+                        fclose(stream.record);
+                        stream.record = nullptr;
+                        ret = 1;
+                    }
+                    stream.parser.feed(buffer, static_cast<size_t>(n), monotonic_ns());
+                }
+                if (n == 0 || (fds[i].revents & POLLHUP)) {
+                    ended = true;
+                }
+
+                if (ended) {
+                    fprintf(stderr, "%s: end of stream\n", stream.name.c_str());
+                    if (!close_stream(&stream)) {
+                        ret = 1;
+                    }
+                    fds[i].fd = -1;  // poll ignores negative descriptors
+                    open_streams--;
+                }
+            }
+
+            int64_t now = monotonic_ns();
+            if (now - window_start < interval_ns) {
+                continue;
+            }
+            double seconds = static_cast<double>(now - window_start) / 1e9;
+            window_start = now;
+
+            for (auto& entry : streams) {
+                Stream& stream = *entry;
+                const StreamStats& stats = stream.parser.stats();
+                double gap_ms = stream.window_gaps > 0
+                    ? static_cast<double>(stream.window_gap_total_ns) / 1e6 / static_cast<double>(stream.window_gaps)
+                    : 0.0;
+                printf("%s: %.1f fps  interval avg/max %.1f/%.1f ms  frames %llu  "
+                    "dropped %llu  resyncs %llu  errors %llu\n",
+                    stream.name.c_str(),
+                    static_cast<double>(stream.window_frames) / seconds,
+                    gap_ms,
+                    static_cast<double>(stream.window_gap_max_ns) / 1e6,
+                    static_cast<unsigned long long>(stats.frames),
+                    static_cast<unsigned long long>(stats.dropped_frames),
+                    static_cast<unsigned long long>(stats.resyncs),
+                    static_cast<unsigned long long>(stats.parse_errors));
+                print_device_timing(stream);
+                if (options.zones && stats.frames) {
+                    print_zones(stream.last);
+                }
+                stream.reset_window();
+            }
+            fflush(stdout);
+        }
+
+        for (auto& entry : streams) {
+            if (entry->fd >= 0 && !close_stream(entry.get())) {
+                ret = 1;
+            }
+        }
+        return ret;
+    }
+
+    void handle_signal(int sig) {
+        (void)sig;
+        g_stop = 1;
+    }
+
+} // namespace
+} // namespace tof_host
+
+int main(int argc, char** argv) {
+    using namespace tof_host;
+
+    Options options;
+    if (!parse_options(argc, argv, &options)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    bool serial = is_serial_device(options.inputs[0]);
+    for (const char* input : options.inputs) {
+        if (is_serial_device(input) != serial) {
+            fprintf(stderr, "Cannot mix serial devices and capture files\n");
+            return 1;
+        }
+    }
+
+    std::vector<std::unique_ptr<Stream>> streams;
+    for (size_t i = 0; i < options.inputs.size(); i++) {
+        streams.push_back(std::make_unique<Stream>(options.inputs[i]));
+        if (!open_outputs(options, streams.back().get(), i)) {
+            return 1;
+        }
+    }
+
+    signal(SIGINT, handle_signal);
+    signal(SIGTERM, handle_signal);
+
+    int ret = serial ? live(options, streams) : replay(options, streams);
+
+    for (auto& stream : streams) {
+        if (!stream->writer.close() || stream->export_failed) {
+            ret = 1;
+        }
+    }
+    return ret;
+}
@@ -0,0 +1,137 @@
+// tof_synth.cc
+// Write a synthetic capture in the device serial format, for replay benchmarks.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+namespace {
+
+    constexpr int kZonesPerSide = 8;
+    constexpr int kZones = kZonesPerSide * kZonesPerSide;
+    constexpr int kLatencyReportFrames = 30;
+
+    uint32_t next_random(uint32_t* state) {
+        *state = *state * 1664525u + 1013904223u;
+        return *state >> 8;
+    }
+
+    // Same layout as print_results and the $NOB/$OGD/$NOL packets in tof_task.cc
+    void write_frame(FILE* out, uint32_t sequence, uint32_t* state, bool packets_only) {
+        int distance[kZones];
+        bool detected[kZones];
+        bool valid[kZones];
+        int signal[kZones];
+        for (int zone = 0; zone < kZones; zone++) {
+            uint32_t r = next_random(state);
+            detected[zone] = r % 16 != 0;
+            valid[zone] = detected[zone] && r % 8 != 1;
+            distance[zone] = 400 + (zone % kZonesPerSide) * 200 + static_cast<int>(r % 50);
+            if (r % 97 == 0) {
+                distance[zone] = -static_cast<int>(r % 20);  // The ULD can report <= 0
+            }
+            valid[zone] = valid[zone] && distance[zone] > 0;
+            signal[zone] = 100 + static_cast<int>(r % 900);
+        }
+
+        int min_mm = 0xFFFF, min_zone = 0xFF, count = 0;
+        for (int zone = 0; zone < kZones; zone++) {
+            if (valid[zone]) {
+                count++;
+                if (distance[zone] < min_mm) {
+                    min_mm = distance[zone];
+                    min_zone = zone;
+                }
+            }
+        }
+        fprintf(out, "$NOB,%u,%u,%d:%d:%d\r\n", sequence, 3 + next_random(state) % 3, min_mm, min_zone, count);
+        fprintf(out, "$OGD,%u,%u,2,0,0A4C0E0A4D0E\r\n", sequence, 150 + next_random(state) % 40);
+
+        if (packets_only) {
+            // kPrintFullFrame off
+            if ((sequence + 1) % kLatencyReportFrames == 0) {
+                fprintf(out, "$NOL,%d,4,9,5\r\n", kLatencyReportFrames);
+            }
+            return;
+        }
+
+        fprintf(out, "\r\n=== VL53L8CX Sensor Reading (Temp: %d\xc2\xb0" "C) ===\r\n\r\n", 30 + static_cast<int>(sequence / 1000 % 5));
+        fprintf(out, "     ");
+        for (int col = 0; col < kZonesPerSide; col++) {
+            fprintf(out, "  C%d   ", col);
+        }
+        fprintf(out, "\r\n     ");
+        for (int col = 0; col < kZonesPerSide; col++) {
+            fprintf(out, "------");
+        }
+        fprintf(out, "\r\n");
+        for (int row = 0; row < kZonesPerSide; row++) {
+            fprintf(out, "R%d | ", row);
+            for (int col = 0; col < kZonesPerSide; col++) {
+                int zone = row * kZonesPerSide + col;
+                if (!detected[zone]) {
+                    fprintf(out, " ---- ");
+                } else {
+                    fprintf(out, "%5d ", distance[zone]);
+                }
+            }
+            fprintf(out, "|\r\n");
+        }
+        fprintf(out, "     ");
+        for (int col = 0; col < kZonesPerSide; col++) {
+            fprintf(out, "------");
+        }
+        fprintf(out, "\r\n\r\nValid measurements (Status=5, distance > 0):\r\n");
+        for (int zone = 0; zone < kZones; zone++) {
+            if (valid[zone]) {
+                fprintf(out, "Zone %2d: %4dmm (Signal: %4d)\r\n", zone, distance[zone], signal[zone]);
+            }
+        }
+        fprintf(out, "\r\n");
+
+        if ((sequence + 1) % kLatencyReportFrames == 0) {
+            fprintf(out, "$NOL,%d,4,9,5\r\n", kLatencyReportFrames);
+        }
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    // --packets-only writes only the $NOB/$OGD/$NOL packets, as with kPrintFullFrame off
+    bool packets_only = false;
+    const char* args[3] = {};
+    int num_args = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--packets-only") == 0) {
+            packets_only = true;
+        } else if (num_args < 3) {
+            args[num_args++] = argv[i];
+        }
+    }
+
+    if (num_args < 2) {
+        fprintf(stderr, "Usage: %s [--packets-only] <output> <frames> [drop every N]\n", argv[0]);
+        return 1;
+    }
+
+    long frames = atol(args[1]);
+    long drop_every = num_args > 2 ? atol(args[2]) : 0;
+
+    FILE* out = fopen(args[0], "wb");
+    if (!out) {
+        fprintf(stderr, "Failed to open %s\n", args[0]);
+        return 1;
+    }
+
+    uint32_t state = 1;
+    uint32_t sequence = 0;
+    for (long i = 0; i < frames; i++) {
+        if (drop_every > 0 && i > 0 && i % drop_every == 0) {
+            sequence++;  // Skip one device sequence number
+        }
+        write_frame(out, sequence++, &state, packets_only);
+    }
+
+    return fclose(out) == 0 ? 0 : 1;
+}
@@ -0,0 +1,56 @@
+// nearest_obstacle.hh
+#pragma once
+
+// C++ standard library
+#include <stdint.h>
+
+#include "tof_zone.hh"
+
+namespace coralmicro {
+
+    static constexpr int kMaxRois = 8;
+    static constexpr uint16_t kNoObstacleMm = 0xFFFF;
+    static constexpr uint8_t kNoZone = 0xFF;
+
+    // Inclusive zone rectangle, row 0 top, col 0 left as printed by print_results
+    struct Roi {
+        uint8_t row_min;
+        uint8_t row_max;
+        uint8_t col_min;
+        uint8_t col_max;
+    };
+
+    // Closest valid distance in one ROI. min_mm is kNoObstacleMm and zone is
+    // kNoZone when the ROI has no valid zone.
+    struct RoiResult {
+        uint16_t min_mm;
+        uint8_t zone;
+        uint8_t valid_count;
+    };
+
+    struct NearestObstacleFrame {
+        uint32_t sequence;
+        uint32_t compute_us;  // Frame read complete to result ready
+        uint8_t num_rois;
+        RoiResult rois[kMaxRois];
+    };
+
+    class RoiReducer {
+    public:
+        // Precompute the ROI membership mask of every zone
+        bool configure(const Roi* rois, uint8_t num_rois, uint8_t zones_per_side);
+
+        // Single pass over the zones, updating every ROI a zone belongs to
+        void reduce(const int16_t* distance_mm,
+                    const uint8_t* target_status,
+                    const uint8_t* nb_target_detected,
+                    int stride,
+                    NearestObstacleFrame* out) const;
+
+    private:
+        uint8_t masks_[kMaxZones] = {};
+        uint8_t num_rois_ = 0;
+        uint8_t zones_ = 0;
+    };
+
+} // namespace coralmicro
@@ -0,0 +1,125 @@
+// occupancy_grid.hh
+#pragma once
+
+// C++ standard library
+#include <stdint.h>
+#include <stddef.h>
+
+#include "tof_zone.hh"
+
+namespace coralmicro {
+
+    // Grid geometry. The grid is centered on the robot origin, x forward,
+    // y left, z up. kGridDimZ = 1 gives a 2D map of the height band
+    // [kGridMinZMm, kGridMinZMm + kLayerHeightMm), larger values stack layers.
+    static constexpr int kGridDimX = 128;
+    static constexpr int kGridDimY = 128;
+    static constexpr int kGridDimZ = 1;
+    static constexpr int kCellSizeMm = 50;
+    static constexpr int kLayerHeightMm = 1500;
+    static constexpr int kGridMinZMm = 50;
+
+    // Cells are stored in square tiles. A 16x16 tile of int8 cells is 256
+    // bytes, eight 32 byte lines of the M7 D-cache, and the whole 2D grid
+    // (16 KB) fits in the 32 KB D-cache.
+    static constexpr int kTileDim = 16;
+    static constexpr int kTileCells = kTileDim * kTileDim;
+    static constexpr int kCacheLineSize = 32;
+    static constexpr int kTilesX = kGridDimX / kTileDim;
+    static constexpr int kTilesY = kGridDimY / kTileDim;
+    static constexpr int kNumTiles = kTilesX * kTilesY * kGridDimZ;
+    static constexpr int kNumCells = kNumTiles * kTileCells;
+
+    // Log-odds in Q4 fixed point (16 = 1.0). Hit ~ p(0.7), miss ~ p(0.4).
+    static constexpr int8_t kLogOddsHit = 14;
+    static constexpr int8_t kLogOddsMiss = -6;
+    static constexpr int8_t kLogOddsMin = -64;
+    static constexpr int8_t kLogOddsMax = 64;
+
+    // Ray marching
+    static constexpr int kRayStepMm = kCellSizeMm / 2;
+    static constexpr int kMaxRangeMm = 4000;
+    static constexpr int kMaxSensors = 4;
+
+    // Keyframe refresh. Deltas carry absolute values, so re-sending every cell
+    // in round-robin lets a host recover from a lost line or a late connect.
+    // One 32 cell dirty word per frame refreshes the grid every 512 frames.
+    static constexpr int kRefreshCellsPerFrame = 32;
+    static constexpr int kRefreshPeriodFrames = kNumCells / kRefreshCellsPerFrame;
+
+    static_assert(kGridDimX % kTileDim == 0 && kGridDimY % kTileDim == 0,
+        "Grid dimensions must be a multiple of the tile size");
+    static_assert(kTileCells % kCacheLineSize == 0,
+        "Tiles must be a whole number of cache lines");
+    static_assert(kNumCells <= 65536, "Delta cell index is 16 bits");
+
+    // Mounting pose of a sensor relative to the grid origin. Angles are only
+    // used when the sensor is added, the update path is integer only.
+    struct SensorPose {
+        int32_t x_mm;
+        int32_t y_mm;
+        int32_t z_mm;
+        float yaw_deg;    // Rotation about z, positive turns toward +y
+        float pitch_deg;  // Rotation about y, positive tilts up
+    };
+
+    // One changed cell. cell is the row-major index (z * Y + y) * X + x.
+    struct GridDelta {
+        uint16_t cell;
+        int8_t log_odds;
+        uint8_t reserved;
+    };
+
+    class OccupancyGrid {
+    public:
+        OccupancyGrid();
+
+        // Clear all cells to unknown (0) and drop pending deltas
+        void reset();
+
+        // Register a sensor with a 4x4 or 8x8 zone layout (zone = row * side + col,
+        // row 0 top, col 0 left as printed by print_results)
+        bool add_sensor(uint8_t sensor_id, const SensorPose& pose, uint8_t zones_per_side);
+
+        // Integrate one frame. Zone i uses distance_mm[i * stride] and
+        // target_status[i * stride]. Returns the number of rays applied.
+        int integrate(uint8_t sensor_id,
+                      const int16_t* distance_mm,
+                      const uint8_t* target_status,
+                      const uint8_t* nb_target_detected,
+                      int stride);
+
+        // Move up to max_deltas changed cells into out. Cells that do not fit
+        // stay pending for the next call.
+        size_t collect_deltas(GridDelta* out, size_t max_deltas);
+
+        // Mark the next kRefreshCellsPerFrame cells dirty, call once per frame
+        void refresh_next();
+
+        size_t pending_deltas() const { return pending_; }
+        int8_t cell(int x, int y, int z) const;
+
+    private:
+        struct Ray {
+            int32_t per_mm[3];  // Q16 cells travelled per mm along the ray
+        };
+
+        struct Sensor {
+            bool active;
+            uint8_t zones;
+            int32_t origin[3];  // Q16 cell coordinates
+            Ray rays[kMaxZones];
+        };
+
+        void apply(int32_t cx, int32_t cy, int32_t cz, int8_t delta);
+        void mark_dirty(int tile, int word, uint32_t bits);
+
+        alignas(kCacheLineSize) int8_t cells_[kNumTiles][kTileCells];
+        uint32_t dirty_[kNumTiles][kTileCells / 32];
+        uint32_t dirty_tiles_[(kNumTiles + 31) / 32];
+        size_t pending_;
+        int refresh_cursor_;
+        Sensor sensors_[kMaxSensors];
+    };
+
+} // namespace coralmicro
@@ -4,8 +4,10 @@
 // Coral Micro
 #include "third_party/freertos_kernel/include/FreeRTOS.h"
 #include "third_party/freertos_kernel/include/task.h"
+#include "third_party/freertos_kernel/include/queue.h"
 #include "libs/base/i2c.h"
 #include "libs/base/gpio.h"
+#include "libs/base/timer.h"
 
 // VL53L8CX implementation
 extern "C" {
@@ -13,6 +15,8 @@ extern "C" {
 }
 
 #include "platform.hpp"
+#include "occupancy_grid.hh"
+#include "nearest_obstacle.hh"
 
 // C++ standard library
 #include <stdio.h>
@@ -28,10 +32,15 @@ namespace coralmicro {
     bool init_sensor(VL53L8CX_Configuration* dev);
     bool init_gpio();
 
+    // Latest nearest-obstacle result for other tasks, false if none yet
+    bool get_nearest_obstacles(NearestObstacleFrame* frame);
+
     // Helper functions
     const char* get_error_string(uint8_t status);
     void print_sensor_error(const char* operation, uint8_t status);
     void print_results(VL53L8CX_ResultsData* results);
+    void publish_nearest_obstacles(const NearestObstacleFrame* frame);
+    void publish_grid_deltas(OccupancyGrid* grid, GridDelta* deltas, uint32_t update_us);
 
 
 
@@ -43,4 +52,23 @@ namespace coralmicro {
     static constexpr uint8_t kResolution = VL53L8CX_RESOLUTION_8X8;
     static constexpr uint8_t kRangingFrequency = 15; // Hz
     static constexpr uint8_t kIntegrationTime = 10;  // ms
+
+    // Nearest-obstacle fast path, published before any other frame processing
+    static constexpr Roi kRois[] = {
+        {0, 7, 0, 7},  // Full field of view
+        {2, 5, 2, 5},  // Center
+        {0, 7, 0, 3},  // Left half
+        {0, 7, 4, 7},  // Right half
+    };
+    static constexpr uint8_t kNumRois = sizeof(kRois) / sizeof(kRois[0]);
+    static constexpr Gpio kObstacleAlertPin = Gpio::kPwm1;
+    static constexpr uint16_t kObstacleAlertMm = 300;  // Pin high when any ROI is closer
+    static constexpr uint32_t kLatencyReportFrames = 30;
+
+    // Occupancy grid fusion
+    static constexpr bool kPublishGridDeltas = true;
+    static constexpr bool kPrintFullFrame = true;  // false leaves the packets as the only per-frame output
+    static constexpr size_t kMaxGridDeltasPerFrame = 128;
+    static constexpr uint8_t kSensorId = 0;
+    static constexpr SensorPose kSensorPose = {0, 0, 100, 0.0f, 0.0f};  // Forward facing, 10cm up
 }
@@ -0,0 +1,19 @@
+// tof_zone.hh
+#pragma once
+
+// C++ standard library
+#include <stdint.h>
+
+namespace coralmicro {
+
+    static constexpr int kMaxZones = 64;
+
+    // Target status the ULD reports for a fully valid measurement
+    static constexpr uint8_t kValidTargetStatus = 5;
+
+    // Single validity rule shared by the fast path, the grid and print_results
+    inline bool is_valid_zone(uint8_t nb_target_detected, uint8_t target_status, int16_t distance_mm) {
+        return nb_target_detected > 0 && target_status == kValidTargetStatus && distance_mm > 0;
+    }
+
+} // namespace coralmicro
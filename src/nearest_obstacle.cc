@@ -0,0 +1,69 @@
+// nearest_obstacle.cc
+#include "nearest_obstacle.hh"
+
+namespace coralmicro {
+
+    bool RoiReducer::configure(const Roi* rois, uint8_t num_rois, uint8_t zones_per_side) {
+        if (num_rois > kMaxRois || (zones_per_side != 4 && zones_per_side != 8)) {
+            return false;
+        }
+
+        for (int i = 0; i < num_rois; i++) {
+            if (rois[i].row_min > rois[i].row_max || rois[i].row_max >= zones_per_side ||
+                rois[i].col_min > rois[i].col_max || rois[i].col_max >= zones_per_side) {
+                return false;
+            }
+        }
+
+        zones_ = zones_per_side * zones_per_side;
+        num_rois_ = num_rois;
+
+        for (int zone = 0; zone < zones_; zone++) {
+            int row = zone / zones_per_side;
+            int col = zone % zones_per_side;
+            uint8_t mask = 0;
+            for (int i = 0; i < num_rois; i++) {
+                if (row >= rois[i].row_min && row <= rois[i].row_max &&
+                    col >= rois[i].col_min && col <= rois[i].col_max) {
+                    mask |= 1u << i;
+                }
+            }
+            masks_[zone] = mask;
+        }
+
+        return true;
+    }
+
+    void RoiReducer::reduce(const int16_t* distance_mm,
+                            const uint8_t* target_status,
+                            const uint8_t* nb_target_detected,
+                            int stride,
+                            NearestObstacleFrame* out) const {
+        out->num_rois = num_rois_;
+        for (int i = 0; i < num_rois_; i++) {
+            out->rois[i] = {kNoObstacleMm, kNoZone, 0};
+        }
+
+        for (int zone = 0; zone < zones_; zone++) {
+            uint32_t mask = masks_[zone];
+            if (!mask || !is_valid_zone(nb_target_detected[zone],
+                                        target_status[zone * stride],
+                                        distance_mm[zone * stride])) {
+                continue;
+            }
+
+            int16_t distance = distance_mm[zone * stride];
+
+            while (mask) {
+                RoiResult& roi = out->rois[__builtin_ctz(mask)];
+                mask &= mask - 1;
+                roi.valid_count++;
+                if (static_cast<uint16_t>(distance) < roi.min_mm) {
+                    roi.min_mm = static_cast<uint16_t>(distance);
+                    roi.zone = static_cast<uint8_t>(zone);
+                }
+            }
+        }
+    }
+
+} // namespace coralmicro
@@ -0,0 +1,245 @@
+// occupancy_grid.cc
+#include "occupancy_grid.hh"
+
+#include <math.h>
+#include <string.h>
+
+namespace coralmicro {
+
+    namespace {
+        constexpr float kPi = 3.14159265f;
+        constexpr float kSensorFovDeg = 45.0f;  // VL53L8CX square field of view
+        constexpr int32_t kOne = 1 << 16;
+
+        // Grid origin (cell 0,0,0 corner) in robot coordinates
+        constexpr int32_t kGridMinXMm = -(kGridDimX * kCellSizeMm) / 2;
+        constexpr int32_t kGridMinYMm = -(kGridDimY * kCellSizeMm) / 2;
+
+        int32_t to_q16(float value) {
+            return static_cast<int32_t>(lroundf(value * kOne));
+        }
+    }
+
+    OccupancyGrid::OccupancyGrid() {
+        memset(sensors_, 0, sizeof(sensors_));
+        reset();
+    }
+
+    void OccupancyGrid::reset() {
+        memset(cells_, 0, sizeof(cells_));
+        memset(dirty_, 0, sizeof(dirty_));
+        memset(dirty_tiles_, 0, sizeof(dirty_tiles_));
+        pending_ = 0;
+        refresh_cursor_ = 0;
+    }
+
+    bool OccupancyGrid::add_sensor(uint8_t sensor_id, const SensorPose& pose, uint8_t zones_per_side) {
+        if (sensor_id >= kMaxSensors || (zones_per_side != 4 && zones_per_side != 8)) {
+            return false;
+        }
+
+        Sensor& sensor = sensors_[sensor_id];
+        sensor.zones = zones_per_side * zones_per_side;
+        sensor.origin[0] = to_q16(static_cast<float>(pose.x_mm - kGridMinXMm) / kCellSizeMm);
+        sensor.origin[1] = to_q16(static_cast<float>(pose.y_mm - kGridMinYMm) / kCellSizeMm);
+        sensor.origin[2] = to_q16(static_cast<float>(pose.z_mm - kGridMinZMm) / kLayerHeightMm);
+
+        const float zone_fov = kSensorFovDeg / zones_per_side * kPi / 180.0f;
+        const float half = zones_per_side / 2.0f;
+        const float yaw = pose.yaw_deg * kPi / 180.0f;
+        const float pitch = pose.pitch_deg * kPi / 180.0f;
+
+        for (int row = 0; row < zones_per_side; row++) {
+            for (int col = 0; col < zones_per_side; col++) {
+                // Zone center direction in the sensor frame (x along boresight)
+                float az = (half - static_cast<float>(col) - 0.5f) * zone_fov;
+                float el = (half - static_cast<float>(row) - 0.5f) * zone_fov;
+                float sx = cosf(el) * cosf(az);
+                float sy = cosf(el) * sinf(az);
+                float sz = sinf(el);
+
+                // Pitch about y, then yaw about z
+                float px = sx * cosf(pitch) - sz * sinf(pitch);
+                float pz = sx * sinf(pitch) + sz * cosf(pitch);
+                float wx = px * cosf(yaw) - sy * sinf(yaw);
+                float wy = px * sinf(yaw) + sy * cosf(yaw);
+
+                Ray& ray = sensor.rays[row * zones_per_side + col];
+                ray.per_mm[0] = to_q16(wx / kCellSizeMm);
+                ray.per_mm[1] = to_q16(wy / kCellSizeMm);
+                ray.per_mm[2] = to_q16(pz / kLayerHeightMm);
+            }
+        }
+
+        sensor.active = true;
+        return true;
+    }
+
+    void OccupancyGrid::apply(int32_t cx, int32_t cy, int32_t cz, int8_t delta) {
+        int tile = (cz * kTilesY + cy / kTileDim) * kTilesX + cx / kTileDim;
+        int offset = (cy % kTileDim) * kTileDim + cx % kTileDim;
+
+        int8_t& cell = cells_[tile][offset];
+        int value = cell + delta;
+        if (value > kLogOddsMax) {
+            value = kLogOddsMax;
+        } else if (value < kLogOddsMin) {
+            value = kLogOddsMin;
+        }
+        if (value == cell) {
+            return;
+        }
+        cell = static_cast<int8_t>(value);
+
+        mark_dirty(tile, offset / 32, 1u << (offset % 32));
+    }
+
+    void OccupancyGrid::mark_dirty(int tile, int word, uint32_t bits) {
+        uint32_t& dirty = dirty_[tile][word];
+        uint32_t added = bits & ~dirty;
+        if (added) {
+            dirty |= added;
+            dirty_tiles_[tile / 32] |= 1u << (tile % 32);
+            pending_ += __builtin_popcount(added);
+        }
+    }
+
+    void OccupancyGrid::refresh_next() {
+        static_assert(kRefreshCellsPerFrame == 32, "Refresh marks one dirty word per frame");
+        constexpr int kWordsPerTile = kTileCells / 32;
+
+        mark_dirty(refresh_cursor_ / kWordsPerTile, refresh_cursor_ % kWordsPerTile, 0xFFFFFFFFu);
+        refresh_cursor_ = (refresh_cursor_ + 1) % (kNumTiles * kWordsPerTile);
+    }
+
+    int OccupancyGrid::integrate(uint8_t sensor_id,
+                                 const int16_t* distance_mm,
+                                 const uint8_t* target_status,
+                                 const uint8_t* nb_target_detected,
+                                 int stride) {
+        if (sensor_id >= kMaxSensors || !sensors_[sensor_id].active) {
+            return 0;
+        }
+
+        const Sensor& sensor = sensors_[sensor_id];
+        int applied = 0;
+
+        for (int zone = 0; zone < sensor.zones; zone++) {
+            if (!is_valid_zone(nb_target_detected[zone],
+                               target_status[zone * stride],
+                               distance_mm[zone * stride])) {
+                continue;
+            }
+
+            int32_t distance = distance_mm[zone * stride];
+            bool hit = distance <= kMaxRangeMm;
+            if (!hit) {
+                distance = kMaxRangeMm;
+            }
+
+            const Ray& ray = sensor.rays[zone];
+
+            // End cell of the ray
+            int32_t ex = (sensor.origin[0] + ray.per_mm[0] * distance) >> 16;
+            int32_t ey = (sensor.origin[1] + ray.per_mm[1] * distance) >> 16;
+            int32_t ez = (sensor.origin[2] + ray.per_mm[2] * distance) >> 16;
+
+            // March free space in half-cell steps, one miss per traversed cell
+            int32_t step[3] = {
+                ray.per_mm[0] * kRayStepMm,
+                ray.per_mm[1] * kRayStepMm,
+                ray.per_mm[2] * kRayStepMm,
+            };
+            int32_t pos[3] = {sensor.origin[0], sensor.origin[1], sensor.origin[2]};
+            int32_t last_x = -1, last_y = -1, last_z = -1;
+            int steps = distance / kRayStepMm;
+
+            for (int i = 0; i < steps; i++) {
+                pos[0] += step[0];
+                pos[1] += step[1];
+                pos[2] += step[2];
+                int32_t cx = pos[0] >> 16;
+                int32_t cy = pos[1] >> 16;
+                int32_t cz = pos[2] >> 16;
+                if (cx == last_x && cy == last_y && cz == last_z) {
+                    continue;
+                }
+                last_x = cx;
+                last_y = cy;
+                last_z = cz;
+                if (cx == ex && cy == ey && cz == ez) {
+                    break;
+                }
+                if (static_cast<uint32_t>(cx) < kGridDimX &&
+                    static_cast<uint32_t>(cy) < kGridDimY &&
+                    static_cast<uint32_t>(cz) < kGridDimZ) {
+                    apply(cx, cy, cz, kLogOddsMiss);
+                }
+            }
+
+            if (hit &&
+                static_cast<uint32_t>(ex) < kGridDimX &&
+                static_cast<uint32_t>(ey) < kGridDimY &&
+                static_cast<uint32_t>(ez) < kGridDimZ) {
+                apply(ex, ey, ez, kLogOddsHit);
+            }
+            applied++;
+        }
+
+        return applied;
+    }
+
+    size_t OccupancyGrid::collect_deltas(GridDelta* out, size_t max_deltas) {
+        size_t count = 0;
+
+        for (int group = 0; group < (kNumTiles + 31) / 32 && count < max_deltas; group++) {
+            while (dirty_tiles_[group] && count < max_deltas) {
+                int tile = group * 32 + __builtin_ctz(dirty_tiles_[group]);
+                int tz = tile / (kTilesX * kTilesY);
+                int ty = (tile / kTilesX) % kTilesY;
+                int tx = tile % kTilesX;
+
+                for (int w = 0; w < kTileCells / 32 && count < max_deltas; w++) {
+                    uint32_t& word = dirty_[tile][w];
+                    while (word && count < max_deltas) {
+                        int offset = w * 32 + __builtin_ctz(word);
+                        word &= word - 1;
+
+                        int x = tx * kTileDim + offset % kTileDim;
+                        int y = ty * kTileDim + offset / kTileDim;
+                        out[count].cell = static_cast<uint16_t>((tz * kGridDimY + y) * kGridDimX + x);
+                        out[count].log_odds = cells_[tile][offset];
+                        out[count].reserved = 0;
+                        count++;
+                    }
+                }
+
+                bool tile_clean = true;
+                for (int w = 0; w < kTileCells / 32; w++) {
+                    if (dirty_[tile][w]) {
+                        tile_clean = false;
+                        break;
+                    }
+                }
+                if (!tile_clean) {
+                    break;
+                }
+                dirty_tiles_[group] &= ~(1u << (tile % 32));
+            }
+        }
+
+        pending_ -= count;
+        return count;
+    }
+
+    int8_t OccupancyGrid::cell(int x, int y, int z) const {
+        if (static_cast<unsigned>(x) >= kGridDimX ||
+            static_cast<unsigned>(y) >= kGridDimY ||
+            static_cast<unsigned>(z) >= kGridDimZ) {
+            return 0;
+        }
+        int tile = (z * kTilesY + y / kTileDim) * kTilesX + x / kTileDim;
+        return cells_[tile][(y % kTileDim) * kTileDim + x % kTileDim];
+    }
+
+} // namespace coralmicro
@@ -3,6 +3,73 @@
 
 namespace coralmicro {
 
+    namespace {
+        // Single slot mailbox holding the latest nearest-obstacle result
+        QueueHandle_t nearest_obstacle_mailbox = nullptr;
+
+        struct LatencyStats {
+            uint32_t frames;
+            uint32_t min_us;
+            uint32_t max_us;
+            uint64_t total_us;
+        };
+
+        void record_latency(LatencyStats* stats, uint32_t latency_us) {
+            if (stats->frames == 0 || latency_us < stats->min_us) {
+                stats->min_us = latency_us;
+            }
+            if (latency_us > stats->max_us) {
+                stats->max_us = latency_us;
+            }
+            stats->total_us += latency_us;
+            stats->frames++;
+        }
+
+        void print_latency_stats(LatencyStats* stats) {
+            // $NOL,<frames>,<min us>,<max us>,<avg us>
+            printf("$NOL,%lu,%lu,%lu,%lu\r\n",
+                static_cast<unsigned long>(stats->frames),
+                static_cast<unsigned long>(stats->min_us),
+                static_cast<unsigned long>(stats->max_us),
+                static_cast<unsigned long>(stats->total_us / stats->frames));
+            fflush(stdout);
+            *stats = {};
+        }
+    } // namespace
+
+    bool get_nearest_obstacles(NearestObstacleFrame* frame) {
+        if (nearest_obstacle_mailbox == nullptr) {
+            return false;
+        }
+        return xQueuePeek(nearest_obstacle_mailbox, frame, 0) == pdTRUE;
+    }
+
+    void publish_nearest_obstacles(const NearestObstacleFrame* frame) {
+        bool alert = false;
+        for (int i = 0; i < frame->num_rois; i++) {
+            if (frame->rois[i].min_mm < kObstacleAlertMm) {
+                alert = true;
+            }
+        }
+        GpioSet(kObstacleAlertPin, alert);
+
+        xQueueOverwrite(nearest_obstacle_mailbox, frame);
+
+        // Tiny packet: $NOB,<seq>,<compute us>,<min mm>:<zone>:<valid count>,...
+        printf("$NOB,%lu,%lu",
+            static_cast<unsigned long>(frame->sequence),
+            static_cast<unsigned long>(frame->compute_us));
+        for (int i = 0; i < frame->num_rois; i++) {
+            printf(",%u:%u:%u",
+                frame->rois[i].min_mm,
+                frame->rois[i].zone,
+                frame->rois[i].valid_count);
+        }
+        printf("\r\n");
+        
+        fflush(stdout);
+    }
+
     void print_results(VL53L8CX_ResultsData* results) {
         // Print header with temperature
         printf("\r\n=== VL53L8CX Sensor Reading (Temp: %d°C) ===\r\n\r\n", 
@@ -46,10 +113,11 @@ namespace coralmicro {
         printf("\r\n\r\n");
         
         // Print statistics for valid measurements only
-        printf("Valid measurements (Status=5):\r\n");
+        printf("Valid measurements (Status=5, distance > 0):\r\n");
         for(uint8_t i = 0; i < kResolution; i++) {
-            if(results->nb_target_detected[i] > 0 && 
-            results->target_status[i] == 5) {
+            if(is_valid_zone(results->nb_target_detected[i],
+                             results->target_status[i],
+                             results->distance_mm[i])) {
                 printf("Zone %2d: %4dmm (Signal: %4d)\r\n", 
                     i, 
                     results->distance_mm[i],
@@ -61,12 +129,48 @@ namespace coralmicro {
         fflush(stdout);
     }
 
+    void publish_grid_deltas(OccupancyGrid* grid, GridDelta* deltas, uint32_t update_us) {
+        static const char kHex[] = "0123456789ABCDEF";
+        static uint32_t sequence = 0;
+
+        grid->refresh_next();
+        size_t count = grid->collect_deltas(deltas, kMaxGridDeltasPerFrame);
+
+        // Compact line: $OGD,<seq>,<update us>,<count>,<pending>,<cell:4 hex><log odds:2 hex>...
+        char line[64 + kMaxGridDeltasPerFrame * 6];
+        int len = snprintf(line, sizeof(line), "$OGD,%lu,%lu,%u,%u,",
+            static_cast<unsigned long>(sequence++),
+            static_cast<unsigned long>(update_us),
+            static_cast<unsigned>(count),
+            static_cast<unsigned>(grid->pending_deltas()));
+        char* p = line + len;
+        for (size_t i = 0; i < count; i++) {
+            uint16_t cell = deltas[i].cell;
+            uint8_t value = static_cast<uint8_t>(deltas[i].log_odds);
+            *p++ = kHex[(cell >> 12) & 0xF];
+            *p++ = kHex[(cell >> 8) & 0xF];
+            *p++ = kHex[(cell >> 4) & 0xF];
+            *p++ = kHex[cell & 0xF];
+            *p++ = kHex[value >> 4];
+            *p++ = kHex[value & 0xF];
+        }
+        *p++ = '\r';
+        *p++ = '\n';
+        fwrite(line, 1, p - line, stdout);
+        
+        fflush(stdout);
+    }
+
     bool init_gpio() {
         printf("GPIO Power-on sequence starting...\r\n");
         
         // Configure LPn pin
         GpioSetMode(kLpnPin, GpioMode::kOutput);
         
+        // Configure obstacle alert pin, low until the first frame
+        GpioSetMode(kObstacleAlertPin, GpioMode::kOutput);
+        GpioSet(kObstacleAlertPin, false);
+        
         // Reset sequence
         GpioSet(kLpnPin, false);  // Assert reset
         vTaskDelay(pdMS_TO_TICKS(100));  // Increased delay
@@ -243,6 +347,36 @@ namespace coralmicro {
             return;
         }
         
+        // Occupancy grid and delta buffer on heap
+        auto grid = std::make_unique<OccupancyGrid>();
+        auto deltas = std::make_unique<GridDelta[]>(kMaxGridDeltasPerFrame);
+        if (!grid || !deltas) {
+            printf("Failed to allocate occupancy grid\r\n");
+            return;
+        }
+        
+        uint8_t zones_per_side = (kResolution == VL53L8CX_RESOLUTION_8X8) ? 8 : 4;
+        if (!grid->add_sensor(kSensorId, kSensorPose, zones_per_side)) {
+            printf("Failed to add sensor to occupancy grid\r\n");
+            return;
+        }
+        
+        // Nearest-obstacle fast path
+        RoiReducer roi_reducer;
+        if (!roi_reducer.configure(kRois, kNumRois, zones_per_side)) {
+            printf("Invalid nearest-obstacle ROI configuration\r\n");
+            return;
+        }
+        
+        nearest_obstacle_mailbox = xQueueCreate(1, sizeof(NearestObstacleFrame));
+        if (nearest_obstacle_mailbox == nullptr) {
+            printf("Failed to create nearest-obstacle mailbox\r\n");
+            return;
+        }
+        
+        NearestObstacleFrame nearest = {};
+        LatencyStats latency = {};
+        
         // Main task loop with watchdog
         TickType_t last_wake_time = xTaskGetTickCount();
         const TickType_t frequency = pdMS_TO_TICKS(33);  // Match your YAML config
@@ -256,7 +390,36 @@ namespace coralmicro {
             if (status == VL53L8CX_STATUS_OK && isReady) {
                 status = vl53l8cx_get_ranging_data(dev.get(), results.get());
                 if (status == VL53L8CX_STATUS_OK) {
-                    print_results(results.get());
+                    // Fast path first, latency runs from read complete to packet flushed
+                    uint64_t read_done = TimerMicros();
+                    roi_reducer.reduce(results->distance_mm,
+                        results->target_status,
+                        results->nb_target_detected,
+                        VL53L8CX_NB_TARGET_PER_ZONE,
+                        &nearest);
+                    nearest.compute_us = static_cast<uint32_t>(TimerMicros() - read_done);
+                    publish_nearest_obstacles(&nearest);
+                    nearest.sequence++;
+                    record_latency(&latency, static_cast<uint32_t>(TimerMicros() - read_done));
+                    
+                    uint64_t update_start = TimerMicros();
+                    grid->integrate(kSensorId,
+                        results->distance_mm,
+                        results->target_status,
+                        results->nb_target_detected,
+                        VL53L8CX_NB_TARGET_PER_ZONE);
+                    uint32_t update_us = static_cast<uint32_t>(TimerMicros() - update_start);
+                    
+                    if (kPublishGridDeltas) {
+                        publish_grid_deltas(grid.get(), deltas.get(), update_us);
+                    }
+                    if (kPrintFullFrame) {
+                        print_results(results.get());
+                    }
+                    
+                    if (latency.frames >= kLatencyReportFrames) {
+                        print_latency_stats(&latency);
+                    }
                 } else {
                     print_sensor_error("getting ranging data", status);
                 }